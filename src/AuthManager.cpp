@@ -1,61 +1,16 @@
 #include "AuthManager.h"
 #include "SHA256.h"
 #include "Logger.h"
-#include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <iostream>
 #include <cctype>
 
 // Конструктор
 AuthManager::AuthManager() : m_gen(m_rd()), m_dis(0, UINT64_MAX) {}
 
-// Загрузка базы пользователей из файла
-bool AuthManager::loadUserDatabase(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cout << "Ошибка: Не удалось открыть файл базы: " << filename << std::endl;
-        return false;
-    }
-    
-    std::string line;
-    int userCount = 0;
-    m_users.clear();
-    
-    std::cout << "Загрузка базы пользователей: " << filename << std::endl;
-    
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        if (line[0] == '#') continue;
-        
-        size_t pos = line.find(':');
-        if (pos != std::string::npos) {
-            std::string login = line.substr(0, pos);
-            std::string password = line.substr(pos + 1);
-            
-            // Убираем пробелы
-            login.erase(0, login.find_first_not_of(" \t"));
-            login.erase(login.find_last_not_of(" \t") + 1);
-            password.erase(0, password.find_first_not_of(" \t"));
-            password.erase(password.find_last_not_of(" \t") + 1);
-            
-            m_users[login] = password;
-            userCount++;
-            
-            std::cout << "Загружен пользователь: " << login << std::endl;
-        }
-    }
-    
-    file.close();
-    
-    std::cout << "Загружено пользователей: " << userCount << std::endl;
-    
-    if (userCount == 0) {
-        std::cout << "Внимание: база пользователей пуста!" << std::endl;
-        return false;
-    }
-    
-    return true;
+// Использование уже загруженной базы пользователей
+void AuthManager::setUserDatabase(std::shared_ptr<const UserDatabase> users) {
+    m_users = std::move(users);
 }
 
 // Генерация соли
@@ -77,14 +32,14 @@ std::string AuthManager::generateSalt() {
 bool AuthManager::authenticate(const std::string& login, const std::string& salt, 
                               const std::string& clientHash) {
     // Ищем пользователя в базе
-    auto it = m_users.find(login);
-    if (it == m_users.end()) {
+    std::string password;
+    if (!m_users || !m_users->find(login, password)) {
         Logger::getInstance().log(LogLevel::ERROR, "Пользователь не найден", "логин: " + login);
         return false;
     }
     
     // Вычисляем хеш на сервере
-    std::string serverHash = computeHash(salt, it->second);
+    std::string serverHash = computeHash(salt, password);
     
     // Приводим к верхнему регистру для сравнения
     std::string clientHashUpper = clientHash;
@@ -2,15 +2,16 @@
 #define AUTHMANAGER_H
 
 #include <string>
-#include <unordered_map>
+#include <memory>
 #include <random>
+#include "UserDatabase.h"
 
 class AuthManager {
 public:
     AuthManager();
     
     // Основные методы
-    bool loadUserDatabase(const std::string& filename);
+    void setUserDatabase(std::shared_ptr<const UserDatabase> users);
     std::string generateSalt();
     bool authenticate(const std::string& login, const std::string& salt, 
                      const std::string& clientHash);
@@ -19,7 +20,7 @@ public:
     void testHashComputation();
     
 private:
-    std::unordered_map<std::string, std::string> m_users;
+    std::shared_ptr<const UserDatabase> m_users;
     std::random_device m_rd;
     std::mt19937 m_gen;
     std::uniform_int_distribution<uint64_t> m_dis;
@@ -1,8 +1,11 @@
 #include "Server.h"
 #include "AuthManager.h"
+#include "UserDatabase.h"
+#include "TrafficCapture.h"
 #include "VectorProcessor.h"
 #include "Logger.h"
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <cstring>
@@ -13,6 +16,8 @@
 // Конструктор сервера
 Server::Server() : m_serverSocket(-1), m_port(0), m_running(false), m_userDbFile("") {}
 
+Server::~Server() = default;
+
 // Инициализация сервера
 bool Server::initialize(const std::string& userDbFile, const std::string& logFile, uint16_t port) {
     m_port = port;
@@ -33,6 +38,11 @@ bool Server::initialize(const std::string& userDbFile, const std::string& logFil
         return false;
     }
     
+    // Загрузка базы пользователей (общая для всех клиентов)
+    if (!loadUserDatabase()) {
+        return false;
+    }
+    
     // Создание сокета
     if (!createSocket()) {
         return false;
@@ -54,6 +64,16 @@ bool Server::initialize(const std::string& userDbFile, const std::string& logFil
     return true;
 }
 
+// Включение записи входящего трафика
+bool Server::enableCapture(const std::string& captureFile, uint32_t sampleEvery, uint64_t maxBytes) {
+    auto capture = std::make_unique<TrafficCapture>();
+    if (!capture->open(captureFile, sampleEvery, maxBytes)) {
+        return false;
+    }
+    m_capture = std::move(capture);
+    return true;
+}
+
 // Остановка сервера
 void Server::stop() {
     m_running = false;
@@ -64,6 +84,85 @@ void Server::stop() {
     Logger::getInstance().log(LogLevel::INFO, "Сервер остановлен");
 }
 
+// Загрузка базы пользователей при инициализации
+bool Server::loadUserDatabase() {
+    // Отметка снимается до загрузки, чтобы изменение файла во время загрузки
+    // привело к повторной загрузке
+    readFileStamp(m_userDbFile, m_userDbStamp);
+    
+    auto users = readUserDatabase();
+    if (!users) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_usersMutex);
+    m_users = std::move(users);
+    return true;
+}
+
+// Чтение базы пользователей: скомпилированная база отображается в память,
+// текстовая компилируется в памяти
+std::shared_ptr<const UserDatabase> Server::readUserDatabase() {
+    auto users = std::make_shared<UserDatabase>();
+    if (!users->load(m_userDbFile)) {
+        Logger::getInstance().log(LogLevel::ERROR, "Не удалось загрузить базу пользователей", 
+                                 "файл: " + m_userDbFile);
+        return nullptr;
+    }
+    
+    if (users->size() == 0) {
+        Logger::getInstance().log(LogLevel::ERROR, "База пользователей пуста", 
+                                 "файл: " + m_userDbFile);
+        return nullptr;
+    }
+    
+    Logger::getInstance().log(LogLevel::INFO, "База пользователей загружена", 
+                             "пользователей: " + std::to_string(users->size()));
+    return users;
+}
+
+// Текущая база пользователей; при изменении файла база перезагружается.
+// Если новая база не загрузилась, продолжает использоваться прежняя
+std::shared_ptr<const UserDatabase> Server::currentUserDatabase() {
+    FileStamp stamp;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_usersMutex);
+        if (!readFileStamp(m_userDbFile, stamp) ||
+            (stamp.device == m_userDbStamp.device && stamp.inode == m_userDbStamp.inode &&
+             stamp.size == m_userDbStamp.size && stamp.mtimeNs == m_userDbStamp.mtimeNs)) {
+            return m_users;
+        }
+        // Перезагрузку выполняет только один поток, остальные пока используют прежнюю базу
+        m_userDbStamp = stamp;
+        generation = ++m_userDbGeneration;
+    }
+    
+    Logger::getInstance().log(LogLevel::INFO, "Файл базы пользователей изменен, перезагрузка", 
+                             "файл: " + m_userDbFile);
+    auto users = readUserDatabase();
+    
+    std::lock_guard<std::mutex> lock(m_usersMutex);
+    // Более поздняя перезагрузка не должна быть перезаписана более ранней
+    if (users && generation == m_userDbGeneration) {
+        m_users = std::move(users);
+    }
+    return m_users;
+}
+
+// Получение признаков изменения файла
+bool Server::readFileStamp(const std::string& filename, FileStamp& stamp) {
+    struct stat st;
+    if (stat(filename.c_str(), &st) < 0) {
+        return false;
+    }
+    stamp.device = st.st_dev;
+    stamp.inode = st.st_ino;
+    stamp.size = st.st_size;
+    stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
 // Создание серверного сокета
 bool Server::createSocket() {
     m_serverSocket = socket(AF_INET, SOCK_STREAM, 0);
@@ -142,11 +241,16 @@ void Server::handleClient(int clientSocket) {
     Logger::getInstance().log(LogLevel::INFO, "Клиент подключился", 
                              "сокет: " + std::to_string(clientSocket));
     
+    uint32_t captureId = m_capture ? m_capture->beginConnection() : 0;
+    
     try {
         // Аутентификация клиента
-        if (!authenticateClient(clientSocket)) {
+        if (!authenticateClient(clientSocket, captureId)) {
             Logger::getInstance().log(LogLevel::ERROR, "Ошибка аутентификации", 
                                      "сокет: " + std::to_string(clientSocket));
+            if (m_capture) {
+                m_capture->endConnection(captureId);
+            }
             close(clientSocket);
             return;
         }
@@ -155,7 +259,7 @@ void Server::handleClient(int clientSocket) {
                                  "сокет: " + std::to_string(clientSocket));
         
         // Обработка векторов от клиента
-        processVectors(clientSocket);
+        processVectors(clientSocket, captureId);
         
     } catch (const std::exception& e) {
         Logger::getInstance().log(LogLevel::ERROR, "Ошибка обработки клиента", 
@@ -163,25 +267,24 @@ void Server::handleClient(int clientSocket) {
                                  ", ошибка: " + e.what());
     }
     
+    if (m_capture) {
+        m_capture->endConnection(captureId);
+    }
     close(clientSocket);
     Logger::getInstance().log(LogLevel::INFO, "Клиент отключился", 
                              "сокет: " + std::to_string(clientSocket));
 }
 
 // Процесс аутентификации клиента
-bool Server::authenticateClient(int clientSocket) {
+bool Server::authenticateClient(int clientSocket, uint32_t captureId) {
     AuthManager authManager;
     
-    // Используем сохраненный путь к базе пользователей
-    if (!authManager.loadUserDatabase(m_userDbFile)) {
-        Logger::getInstance().log(LogLevel::ERROR, "Не удалось загрузить базу пользователей", 
-                                 "файл: " + m_userDbFile);
-        return false;
-    }
+    // Используем текущую базу пользователей (с учетом изменений файла)
+    authManager.setUserDatabase(currentUserDatabase());
     
     // Получение логина от клиента
     char loginBuffer[256];
-    ssize_t bytesRead = recv(clientSocket, loginBuffer, sizeof(loginBuffer) - 1, 0);
+    ssize_t bytesRead = receive(clientSocket, loginBuffer, sizeof(loginBuffer) - 1, captureId);
     if (bytesRead <= 0) {
         return false;
     }
@@ -196,7 +299,7 @@ bool Server::authenticateClient(int clientSocket) {
     
     // Получение хеша от клиента
     char hashBuffer[65];
-    bytesRead = recv(clientSocket, hashBuffer, sizeof(hashBuffer) - 1, 0);
+    bytesRead = receive(clientSocket, hashBuffer, sizeof(hashBuffer) - 1, captureId);
     if (bytesRead <= 0) {
         return false;
     }
@@ -205,6 +308,9 @@ bool Server::authenticateClient(int clientSocket) {
     
     // Проверка аутентификации и отправка результата
     bool authResult = authManager.authenticate(login, salt, clientHash);
+    if (captureId != 0) {
+        m_capture->recordAuth(captureId, authResult);
+    }
     std::string response = authResult ? "OK" : "ERR";
     
     if (send(clientSocket, response.c_str(), response.length(), 0) <= 0) {
@@ -215,10 +321,10 @@ bool Server::authenticateClient(int clientSocket) {
 }
 
 // Обработка векторов от клиента
-void Server::processVectors(int clientSocket) {
+void Server::processVectors(int clientSocket, uint32_t captureId) {
     // Получение количества векторов
     uint32_t numVectors;
-    ssize_t bytesRead = recv(clientSocket, &numVectors, sizeof(numVectors), 0);
+    ssize_t bytesRead = receive(clientSocket, &numVectors, sizeof(numVectors), captureId);
     if (bytesRead != sizeof(numVectors)) {
         throw std::runtime_error("Не удалось получить количество векторов");
     }
@@ -229,7 +335,7 @@ void Server::processVectors(int clientSocket) {
     for (uint32_t i = 0; i < numVectors; i++) {
         // Получение размера вектора
         uint32_t vectorSize;
-        bytesRead = recv(clientSocket, &vectorSize, sizeof(vectorSize), 0);
+        bytesRead = receive(clientSocket, &vectorSize, sizeof(vectorSize), captureId);
         if (bytesRead != sizeof(vectorSize)) {
             throw std::runtime_error("Не удалось получить размер вектора");
         }
@@ -237,7 +343,7 @@ void Server::processVectors(int clientSocket) {
         // Получение данных вектора
         std::vector<uint32_t> vector(vectorSize);
         size_t expectedBytes = vectorSize * sizeof(uint32_t);
-        bytesRead = recv(clientSocket, vector.data(), expectedBytes, 0);
+        bytesRead = receive(clientSocket, vector.data(), expectedBytes, captureId);
         if (bytesRead != static_cast<ssize_t>(expectedBytes)) {
             throw std::runtime_error("Не удалось получить данные вектора");
         }
@@ -254,4 +360,13 @@ void Server::processVectors(int clientSocket) {
     
     Logger::getInstance().log(LogLevel::INFO, "Векторы обработаны", 
                              "количество: " + std::to_string(results.size()));
+}
+
+// Прием данных от клиента с записью в файл трафика
+ssize_t Server::receive(int clientSocket, void* buffer, size_t length, uint32_t captureId) {
+    ssize_t bytesRead = recv(clientSocket, buffer, length, 0);
+    if (captureId != 0 && bytesRead > 0) {
+        m_capture->record(captureId, buffer, static_cast<size_t>(bytesRead));
+    }
+    return bytesRead;
 }
\ No newline at end of file
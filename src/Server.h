@@ -3,11 +3,19 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+
+class UserDatabase;
+class TrafficCapture;
 
 class Server {
 public:
     Server();
+    ~Server();
     bool initialize(const std::string& userDbFile, const std::string& logFile, uint16_t port);
+    bool enableCapture(const std::string& captureFile, uint32_t sampleEvery, uint64_t maxBytes);
     void run();
     void stop();
     
@@ -16,13 +24,31 @@ private:
     uint16_t m_port;
     bool m_running;
     std::string m_userDbFile;
+    std::shared_ptr<const UserDatabase> m_users;
+    std::mutex m_usersMutex;
+    
+    // Признаки изменения файла базы пользователей
+    struct FileStamp {
+        dev_t device = 0;
+        ino_t inode = 0;
+        off_t size = 0;
+        int64_t mtimeNs = 0;
+    };
+    FileStamp m_userDbStamp;
+    uint64_t m_userDbGeneration = 0;
+    std::unique_ptr<TrafficCapture> m_capture;
     
+    bool loadUserDatabase();
+    std::shared_ptr<const UserDatabase> readUserDatabase();
+    std::shared_ptr<const UserDatabase> currentUserDatabase();
+    static bool readFileStamp(const std::string& filename, FileStamp& stamp);
     bool createSocket();
     bool bindSocket();
     bool startListening();
     void handleClient(int clientSocket);
-    bool authenticateClient(int clientSocket);
-    void processVectors(int clientSocket);
+    bool authenticateClient(int clientSocket, uint32_t captureId);
+    void processVectors(int clientSocket, uint32_t captureId);
+    ssize_t receive(int clientSocket, void* buffer, size_t length, uint32_t captureId);
 };
 
 #endif
\ No newline at end of file
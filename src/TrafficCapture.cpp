@@ -0,0 +1,231 @@
+#include "TrafficCapture.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+constexpr char TrafficCapture::MAGIC[4];
+
+namespace {
+
+const size_t RECORD_HEADER_SIZE = 1 + 4 + 8;
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+}
+
+TrafficCapture::TrafficCapture()
+    : m_sampleEvery(1), m_maxBytes(0), m_bytesWritten(0), m_connectionCount(0),
+      m_nextId(1), m_full(true) {}
+
+TrafficCapture::~TrafficCapture() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+// Открытие файла записи
+bool TrafficCapture::open(const std::string& filename, uint32_t sampleEvery, uint64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        Logger::getInstance().log(LogLevel::ERROR, "Не удалось открыть файл записи трафика",
+                                 "файл: " + filename);
+        return false;
+    }
+
+    m_file.write(MAGIC, sizeof(MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    m_file.flush();
+
+    m_start = std::chrono::steady_clock::now();
+    m_sampleEvery = sampleEvery > 0 ? sampleEvery : 1;
+    m_maxBytes = maxBytes;
+    m_bytesWritten = sizeof(MAGIC) + sizeof(VERSION);
+    m_connectionCount = 0;
+    m_nextId = 1;
+    m_full = false;
+
+    Logger::getInstance().log(LogLevel::INFO, "Запись трафика включена",
+                             "файл: " + filename +
+                             ", каждое соединение из: " + std::to_string(m_sampleEvery) +
+                             ", лимит байт: " + std::to_string(m_maxBytes));
+    return true;
+}
+
+// Начало записи соединения (с учетом выборки)
+uint32_t TrafficCapture::beginConnection() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_full) {
+        return 0;
+    }
+    if (m_connectionCount++ % m_sampleEvery != 0) {
+        return 0;
+    }
+
+    uint32_t id = m_nextId++;
+    if (!writeRecord(RecordType::OPEN, id, nullptr, 0)) {
+        return 0;
+    }
+    return id;
+}
+
+// Запись принятых от клиента данных
+void TrafficCapture::record(uint32_t connectionId, const void* data, size_t length) {
+    if (connectionId == 0 || length == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    writeRecord(RecordType::DATA, connectionId, data, length);
+}
+
+// Запись результата аутентификации
+void TrafficCapture::recordAuth(uint32_t connectionId, bool success) {
+    if (connectionId == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    writeRecord(success ? RecordType::AUTH_OK : RecordType::AUTH_FAILED, connectionId, nullptr, 0);
+}
+
+// Завершение записи соединения
+void TrafficCapture::endConnection(uint32_t connectionId) {
+    if (connectionId == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (writeRecord(RecordType::CLOSE, connectionId, nullptr, 0)) {
+        m_file.flush();
+    }
+}
+
+// Чтение файла записи
+bool TrafficCapture::load(const std::string& filename, std::vector<Connection>& connections) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Ошибка: Не удалось открыть файл записи трафика: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    if (!file.read(magic, sizeof(magic)) || !readValue(file, version) ||
+        std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+        std::cerr << "Ошибка: Неподдерживаемый формат записи трафика: " << filename << std::endl;
+        return false;
+    }
+
+    connections.clear();
+    std::unordered_map<uint32_t, size_t> index;
+
+    while (true) {
+        uint8_t type;
+        uint32_t id;
+        uint64_t timestamp;
+        if (!readValue(file, type)) {
+            break;
+        }
+        // Запись могла оборваться при остановке сервера
+        if (!readValue(file, id) || !readValue(file, timestamp)) {
+            break;
+        }
+
+        if (type == static_cast<uint8_t>(RecordType::OPEN)) {
+            index[id] = connections.size();
+            connections.push_back({id, timestamp, 0, AuthResult::NOT_REACHED, false, {}});
+            continue;
+        }
+
+        auto it = index.find(id);
+        if (type == static_cast<uint8_t>(RecordType::DATA)) {
+            uint32_t length;
+            if (!readValue(file, length)) {
+                break;
+            }
+            std::string data(length, '\0');
+            if (!file.read(&data[0], length)) {
+                break;
+            }
+            if (it != index.end()) {
+                Connection& connection = connections[it->second];
+                uint64_t offset = timestamp - connection.startUs;
+                connection.chunks.push_back({offset, std::move(data)});
+                connection.durationUs = offset;
+            }
+        } else if (type == static_cast<uint8_t>(RecordType::CLOSE)) {
+            if (it != index.end()) {
+                Connection& connection = connections[it->second];
+                connection.durationUs = timestamp - connection.startUs;
+                connection.closed = true;
+            }
+        } else if (type == static_cast<uint8_t>(RecordType::AUTH_OK) ||
+                   type == static_cast<uint8_t>(RecordType::AUTH_FAILED)) {
+            if (it != index.end()) {
+                Connection& connection = connections[it->second];
+                connection.auth = type == static_cast<uint8_t>(RecordType::AUTH_OK)
+                                      ? AuthResult::SUCCEEDED : AuthResult::FAILED;
+            }
+        } else {
+            std::cerr << "Ошибка: Файл записи трафика поврежден: " << filename << std::endl;
+            return false;
+        }
+    }
+
+    // Время начала отсчитывается от первого записанного соединения,
+    // а не от открытия файла, чтобы воспроизведение не простаивало
+    if (!connections.empty()) {
+        uint64_t firstStart = connections.front().startUs;
+        for (const auto& connection : connections) {
+            firstStart = std::min(firstStart, connection.startUs);
+        }
+        for (auto& connection : connections) {
+            connection.startUs -= firstStart;
+        }
+    }
+
+    return true;
+}
+
+uint64_t TrafficCapture::elapsedUs() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+}
+
+// Запись одной записи в файл (вызывается под мьютексом)
+bool TrafficCapture::writeRecord(RecordType type, uint32_t connectionId,
+                                 const void* data, size_t length) {
+    if (m_full || !m_file.is_open()) {
+        return false;
+    }
+
+    size_t recordSize = RECORD_HEADER_SIZE + (type == RecordType::DATA ? sizeof(uint32_t) + length : 0);
+    if (m_bytesWritten + recordSize > m_maxBytes) {
+        m_full = true;
+        m_file.flush();
+        Logger::getInstance().log(LogLevel::INFO, "Запись трафика остановлена: достигнут лимит размера",
+                                 "байт: " + std::to_string(m_bytesWritten));
+        return false;
+    }
+
+    char header[RECORD_HEADER_SIZE];
+    uint64_t timestamp = elapsedUs();
+    header[0] = static_cast<char>(type);
+    std::memcpy(header + 1, &connectionId, sizeof(connectionId));
+    std::memcpy(header + 5, &timestamp, sizeof(timestamp));
+    m_file.write(header, sizeof(header));
+
+    if (type == RecordType::DATA) {
+        uint32_t length32 = static_cast<uint32_t>(length);
+        m_file.write(reinterpret_cast<const char*>(&length32), sizeof(length32));
+        m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    }
+
+    m_bytesWritten += recordSize;
+    return true;
+}
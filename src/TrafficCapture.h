@@ -0,0 +1,85 @@
+#ifndef TRAFFICCAPTURE_H
+#define TRAFFICCAPTURE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Запись входящего трафика клиентов для последующего воспроизведения.
+//
+// Формат файла: сигнатура и версия, затем последовательность записей
+//   type(1) connectionId(4) timestampUs(8) [length(4) data(length)]
+// Метка времени отсчитывается от начала записи, поле длины и данные
+// есть только у записей с данными. Результат аутентификации хранится
+// отдельной записью, чтобы воспроизведение повторяло исходный исход.
+class TrafficCapture {
+public:
+    struct Chunk {
+        uint64_t offsetUs;      // от начала соединения
+        std::string data;
+    };
+
+    // Исход аутентификации; NOT_REACHED - сессия завершилась до проверки хеша
+    enum class AuthResult {
+        NOT_REACHED,
+        SUCCEEDED,
+        FAILED
+    };
+
+    struct Connection {
+        uint32_t id;
+        uint64_t startUs;       // от начала первого соединения
+        uint64_t durationUs;
+        AuthResult auth;
+        bool closed;            // запись не оборвалась до закрытия соединения
+        std::vector<Chunk> chunks;
+    };
+
+    TrafficCapture();
+    ~TrafficCapture();
+    TrafficCapture(const TrafficCapture&) = delete;
+    TrafficCapture& operator=(const TrafficCapture&) = delete;
+
+    // Запись каждого sampleEvery-го соединения, не более maxBytes байт
+    bool open(const std::string& filename, uint32_t sampleEvery, uint64_t maxBytes);
+
+    // Возвращает идентификатор соединения или 0, если оно не записывается
+    uint32_t beginConnection();
+    void record(uint32_t connectionId, const void* data, size_t length);
+    void recordAuth(uint32_t connectionId, bool success);
+    void endConnection(uint32_t connectionId);
+
+    // Чтение файла записи
+    static bool load(const std::string& filename, std::vector<Connection>& connections);
+
+private:
+    enum class RecordType : uint8_t {
+        OPEN = 1,
+        DATA = 2,
+        CLOSE = 3,
+        AUTH_OK = 4,
+        AUTH_FAILED = 5
+    };
+
+    static constexpr char MAGIC[4] = {'V', 'C', 'T', 'R'};
+    static constexpr uint32_t VERSION = 1;
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::chrono::steady_clock::time_point m_start;
+    uint32_t m_sampleEvery;
+    uint64_t m_maxBytes;
+    uint64_t m_bytesWritten;
+    uint64_t m_connectionCount;
+    uint32_t m_nextId;
+    bool m_full;
+
+    uint64_t elapsedUs() const;
+    bool writeRecord(RecordType type, uint32_t connectionId, const void* data, size_t length);
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include "UserDatabase.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+constexpr char UserDatabase::MAGIC[8];
+
+UserDatabase::~UserDatabase() {
+    release();
+}
+
+// Загрузка базы пользователей
+bool UserDatabase::load(const std::string& filename) {
+    release();
+
+    if (isBinary(filename)) {
+        return mapFile(filename);
+    }
+
+    // Текстовый формат компилируется в тот же бинарный образ в памяти
+    std::vector<std::pair<std::string, std::string>> users;
+    if (!parseText(filename, users)) {
+        return false;
+    }
+    try {
+        m_image = buildImage(std::move(users));
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return false;
+    }
+    return attach(m_image.data(), m_image.size(), filename);
+}
+
+// Поиск пароля по логину (двоичный поиск по отсортированным записям)
+bool UserDatabase::find(std::string_view login, std::string& password) const {
+    if (m_data == nullptr) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, m_data, sizeof(header));
+    const char* entries = m_data + sizeof(Header);
+    const char* strings = entries + static_cast<size_t>(header.count) * sizeof(Entry);
+
+    size_t low = 0;
+    size_t high = header.count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        Entry entry;
+        std::memcpy(&entry, entries + mid * sizeof(Entry), sizeof(entry));
+
+        if (static_cast<uint64_t>(entry.loginOffset) + entry.loginLength > header.stringsSize ||
+            static_cast<uint64_t>(entry.passwordOffset) + entry.passwordLength > header.stringsSize) {
+            return false;
+        }
+
+        std::string_view current(strings + entry.loginOffset, entry.loginLength);
+        int cmp = current.compare(login);
+        if (cmp == 0) {
+            password.assign(strings + entry.passwordOffset, entry.passwordLength);
+            return true;
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return false;
+}
+
+// Количество пользователей в базе
+uint32_t UserDatabase::size() const {
+    if (m_data == nullptr) {
+        return 0;
+    }
+    Header header;
+    std::memcpy(&header, m_data, sizeof(header));
+    return header.count;
+}
+
+// Разбор текстового файла login:password
+bool UserDatabase::parseText(const std::string& filename,
+                             std::vector<std::pair<std::string, std::string>>& users) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Ошибка: Не удалось открыть файл базы: " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    users.clear();
+
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        if (line[0] == '#') continue;
+
+        size_t pos = line.find(':');
+        if (pos != std::string::npos) {
+            std::string login = line.substr(0, pos);
+            std::string password = line.substr(pos + 1);
+
+            // Убираем пробелы
+            login.erase(0, login.find_first_not_of(" \t"));
+            login.erase(login.find_last_not_of(" \t") + 1);
+            password.erase(0, password.find_first_not_of(" \t"));
+            password.erase(password.find_last_not_of(" \t") + 1);
+
+            users.emplace_back(std::move(login), std::move(password));
+        }
+    }
+
+    return true;
+}
+
+// Построение бинарного образа базы
+std::string UserDatabase::buildImage(std::vector<std::pair<std::string, std::string>> users) {
+    // Сортировка по логину; при повторах остается последняя запись, как в текстовом формате
+    std::stable_sort(users.begin(), users.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    auto last = std::unique(users.rbegin(), users.rend(),
+                            [](const auto& a, const auto& b) { return a.first == b.first; });
+    users.erase(users.begin(), last.base());
+
+    std::vector<Entry> entries;
+    entries.reserve(users.size());
+    std::string strings;
+
+    for (const auto& user : users) {
+        if (strings.size() + user.first.size() + user.second.size() >
+            std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("База пользователей слишком велика");
+        }
+
+        Entry entry;
+        entry.loginOffset = static_cast<uint32_t>(strings.size());
+        entry.loginLength = static_cast<uint32_t>(user.first.size());
+        strings += user.first;
+        entry.passwordOffset = static_cast<uint32_t>(strings.size());
+        entry.passwordLength = static_cast<uint32_t>(user.second.size());
+        strings += user.second;
+        entries.push_back(entry);
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = static_cast<uint32_t>(entries.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+
+    std::string image;
+    image.reserve(sizeof(Header) + entries.size() * sizeof(Entry) + strings.size());
+    image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    image.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    image += strings;
+    return image;
+}
+
+// Компиляция текстового файла в бинарный
+bool UserDatabase::compile(const std::string& textFile, const std::string& binaryFile) {
+    if (isBinary(textFile)) {
+        std::cerr << "Ошибка: Файл уже скомпилирован: " << textFile << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string>> users;
+    if (!parseText(textFile, users)) {
+        return false;
+    }
+    if (users.empty()) {
+        std::cerr << "Ошибка: В файле нет пользователей: " << textFile << std::endl;
+        return false;
+    }
+
+    std::string image;
+    try {
+        image = buildImage(std::move(users));
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Запись во временный файл с последующим атомарным переименованием,
+    // чтобы работающие серверы не увидели частично записанную базу
+    std::string tmpFile = binaryFile + ".tmp";
+    std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Ошибка: Не удалось открыть файл для записи: " << tmpFile << std::endl;
+        return false;
+    }
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    out.close();
+    if (!out) {
+        std::cerr << "Ошибка: Не удалось записать файл: " << tmpFile << std::endl;
+        std::remove(tmpFile.c_str());
+        return false;
+    }
+
+    if (std::rename(tmpFile.c_str(), binaryFile.c_str()) != 0) {
+        std::cerr << "Ошибка: Не удалось переименовать " << tmpFile << " в " << binaryFile << std::endl;
+        std::remove(tmpFile.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+// Проверка сигнатуры бинарного формата
+bool UserDatabase::isBinary(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Проверка заголовка и подключение образа базы
+bool UserDatabase::attach(const char* data, size_t size, const std::string& filename) {
+    Header header;
+    if (size < sizeof(Header)) {
+        std::cerr << "Ошибка: Файл базы поврежден: " << filename << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Ошибка: Неподдерживаемый формат базы: " << filename << std::endl;
+        return false;
+    }
+
+    uint64_t expected = sizeof(Header) + static_cast<uint64_t>(header.count) * sizeof(Entry) +
+                        header.stringsSize;
+    if (expected != size) {
+        std::cerr << "Ошибка: Файл базы поврежден: " << filename << std::endl;
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+// Отображение бинарного файла в память
+bool UserDatabase::mapFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Ошибка: Не удалось открыть файл базы: " << filename << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+        std::cerr << "Ошибка: Не удалось определить размер файла базы: " << filename << std::endl;
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Ошибка: Не удалось отобразить файл базы в память: " << filename << std::endl;
+        return false;
+    }
+    // Доступ при двоичном поиске случайный, упреждающее чтение бесполезно
+    madvise(mapping, size, MADV_RANDOM);
+
+    m_mapping = mapping;
+    m_mappingSize = size;
+    if (!attach(static_cast<const char*>(mapping), size, filename)) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+// Освобождение отображения и образа
+void UserDatabase::release() {
+    if (m_mapping != nullptr) {
+        munmap(m_mapping, m_mappingSize);
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_image.clear();
+}
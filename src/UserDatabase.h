@@ -0,0 +1,73 @@
+#ifndef USERDATABASE_H
+#define USERDATABASE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// База пользователей в компактном бинарном формате (отсортированная таблица строк).
+//
+// Формат файла:
+//   Header                      - сигнатура (8 байт), версия, число записей, размер блока строк
+//   Entry[count]                - записи, отсортированные по логину
+//   char strings[stringsSize]   - логины и пароли, уложенные подряд
+//
+// Скомпилированный файл отображается в память через mmap, поиск выполняется
+// двоичным поиском прямо по отображению без копирования данных.
+class UserDatabase {
+public:
+    UserDatabase() = default;
+    ~UserDatabase();
+    UserDatabase(const UserDatabase&) = delete;
+    UserDatabase& operator=(const UserDatabase&) = delete;
+
+    // Загрузка базы: бинарный файл отображается в память,
+    // текстовый файл (login:password) компилируется в памяти
+    bool load(const std::string& filename);
+    bool find(std::string_view login, std::string& password) const;
+    uint32_t size() const;
+
+    // Разбор текстового файла login:password
+    static bool parseText(const std::string& filename,
+                          std::vector<std::pair<std::string, std::string>>& users);
+    // Построение бинарного образа базы
+    static std::string buildImage(std::vector<std::pair<std::string, std::string>> users);
+    // Компиляция текстового файла в бинарный
+    static bool compile(const std::string& textFile, const std::string& binaryFile);
+    static bool isBinary(const std::string& filename);
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint32_t stringsSize;
+    };
+
+    struct Entry {
+        uint32_t loginOffset;
+        uint32_t loginLength;
+        uint32_t passwordOffset;
+        uint32_t passwordLength;
+    };
+
+    // Байты NUL и управляющие символы не встречаются в текстовом файле,
+    // поэтому сигнатура не совпадет с логином в первой строке
+    static constexpr char MAGIC[8] = {'V', 'C', 'D', 'B', '\0', '\r', '\n', '\x1a'};
+    static constexpr uint32_t VERSION = 1;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    std::string m_image;
+
+    bool attach(const char* data, size_t size, const std::string& filename);
+    bool mapFile(const std::string& filename);
+    void release();
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <cstdint>
 #include <unistd.h>
 #include <limits.h>
 #include "Server.h"
@@ -13,6 +14,9 @@ void showHelp(const char* programName) {
               << "  -c, --config FILE   Файл базы пользователей (по умолчанию: /etc/vcalc.conf)\n"
               << "  -l, --log FILE      Файл журнала (по умолчанию: /var/log/vcalc.log)\n"
               << "  -p, --port PORT     Номер порта (по умолчанию: 33333, диапазон: 1-65535)\n"
+              << "  -t FILE             Записывать входящий трафик клиентов в файл\n"
+              << "  -s N                Записывать каждое N-е соединение (по умолчанию: 1)\n"
+              << "  -m MB               Максимальный размер файла записи в МБ (по умолчанию: 100)\n"
               << "\nПример:\n"
               << "  " << programName << " -c ./vcalc.conf -l ./vcalc.log -p 33333\n";
 }
@@ -21,6 +25,9 @@ bool fileExists(const std::string& filename) {
     return access(filename.c_str(), F_OK) != -1;
 }
 
+// Наибольший размер файла записи в МБ, при котором размер в байтах не переполняется
+const uint64_t MAX_CAPTURE_LIMIT_MB = UINT64_MAX / (1024 * 1024);
+
 bool validatePort(int port) {
     return port > 0 && port <= 65535;
 }
@@ -29,10 +36,13 @@ int main(int argc, char* argv[]) {
     std::string userDbFile = "/etc/vcalc.conf";
     std::string logFile = "/var/log/vcalc.log";
     int port = 33333;
+    std::string captureFile;
+    uint32_t captureSample = 1;
+    uint64_t captureLimitMb = 100;
     
     // Парсинг аргументов командной строки с использованием getopt
     int opt;
-    while ((opt = getopt(argc, argv, "hc:l:p:")) != -1) {
+    while ((opt = getopt(argc, argv, "hc:l:p:t:s:m:")) != -1) {
         switch (opt) {
             case 'h':
                 showHelp(argv[0]);
@@ -55,6 +65,40 @@ int main(int argc, char* argv[]) {
                     return 1;
                 }
                 break;
+            case 't':
+                captureFile = optarg;
+                break;
+            case 's':
+                try {
+                    int sample = std::stoi(optarg);
+                    if (sample <= 0) {
+                        std::cerr << "Ошибка: Частота выборки должна быть положительной" << std::endl;
+                        return 1;
+                    }
+                    captureSample = static_cast<uint32_t>(sample);
+                } catch (const std::exception& e) {
+                    std::cerr << "Ошибка: Неверный формат частоты выборки: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'm':
+                try {
+                    long long limit = std::stoll(optarg);
+                    if (limit <= 0) {
+                        std::cerr << "Ошибка: Размер файла записи должен быть положительным" << std::endl;
+                        return 1;
+                    }
+                    if (static_cast<uint64_t>(limit) > MAX_CAPTURE_LIMIT_MB) {
+                        std::cerr << "Ошибка: Размер файла записи не должен превышать "
+                                  << MAX_CAPTURE_LIMIT_MB << " МБ" << std::endl;
+                        return 1;
+                    }
+                    captureLimitMb = static_cast<uint64_t>(limit);
+                } catch (const std::exception& e) {
+                    std::cerr << "Ошибка: Неверный формат размера файла записи: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
             case '?':
                 std::cerr << "Неизвестный параметр или отсутствует значение" << std::endl;
                 showHelp(argv[0]);
@@ -92,6 +136,9 @@ int main(int argc, char* argv[]) {
     std::cout << "  База пользователей: " << userDbFile << std::endl;
     std::cout << "  Файл журнала: " << logFile << std::endl;
     std::cout << "  Порт: " << port << std::endl;
+    if (!captureFile.empty()) {
+        std::cout << "  Запись трафика: " << captureFile << std::endl;
+    }
     
     Server server;
     if (!server.initialize(userDbFile, logFile, static_cast<uint16_t>(port))) {
@@ -99,6 +146,12 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (!captureFile.empty() &&
+        !server.enableCapture(captureFile, captureSample, captureLimitMb * 1024 * 1024)) {
+        std::cerr << "Ошибка: Не удалось включить запись трафика: " << captureFile << std::endl;
+        return 1;
+    }
+    
     std::cout << "Сервер запущен. Для остановки нажмите Ctrl+C" << std::endl;
     
     try {
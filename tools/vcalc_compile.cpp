@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "../src/UserDatabase.h"
+
+void showHelp(const char* programName) {
+    std::cout << "Использование: " << programName << " [опции]\n"
+              << "Компиляция текстовой базы пользователей (login:password) в бинарный формат\n"
+              << "Опции:\n"
+              << "  -h, --help          Показать эту справку\n"
+              << "  -i FILE             Текстовый файл базы пользователей (по умолчанию: /etc/vcalc.conf)\n"
+              << "  -o FILE             Бинарный файл базы (по умолчанию: /etc/vcalc.db)\n"
+              << "\nПример:\n"
+              << "  " << programName << " -i ./vcalc.conf -o ./vcalc.db\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputFile = "/etc/vcalc.conf";
+    std::string outputFile = "/etc/vcalc.db";
+    
+    int opt;
+    while ((opt = getopt(argc, argv, "hi:o:")) != -1) {
+        switch (opt) {
+            case 'h':
+                showHelp(argv[0]);
+                return 0;
+            case 'i':
+                inputFile = optarg;
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            default:
+                showHelp(argv[0]);
+                return 1;
+        }
+    }
+    
+    if (!UserDatabase::compile(inputFile, outputFile)) {
+        std::cerr << "Ошибка: Не удалось скомпилировать базу пользователей" << std::endl;
+        return 1;
+    }
+    
+    // Проверка результата
+    UserDatabase users;
+    if (!users.load(outputFile)) {
+        std::cerr << "Ошибка: Скомпилированная база не прошла проверку" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "База скомпилирована: " << outputFile
+              << " (пользователей: " << users.size() << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,490 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "../src/TrafficCapture.h"
+#include "../src/UserDatabase.h"
+#include "../src/SHA256.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const size_t SALT_LENGTH = 16;
+// Опоздание начала соединения, после которого воспроизведение считается неточным
+const uint64_t START_LAG_WARNING_US = 10000;
+
+// Результат воспроизведения одного соединения
+struct ReplayResult {
+    bool connected = false;
+    bool authResponded = false;
+    bool authenticated = false;
+    bool authMismatch = false;      // исход аутентификации отличается от записи
+    bool completed = false;
+    uint64_t bytesSent = 0;
+    uint64_t authLatencyUs = 0;
+    uint64_t startLagUs = 0;        // опоздание начала относительно записи
+    std::vector<uint64_t> vectorLatenciesUs;
+};
+
+// Разбор отправленного потока векторов, чтобы знать, сколько ответов ожидать
+class VectorStream {
+public:
+    uint32_t append(const std::string& data) {
+        m_buffer += data;
+        uint32_t completed = 0;
+
+        while (true) {
+            size_t available = m_buffer.size() - m_pos;
+            if (!m_haveCount) {
+                if (available < sizeof(uint32_t)) break;
+                std::memcpy(&m_remaining, m_buffer.data() + m_pos, sizeof(uint32_t));
+                m_pos += sizeof(uint32_t);
+                m_haveCount = true;
+                continue;
+            }
+            if (m_remaining == 0 || available < sizeof(uint32_t)) break;
+
+            uint32_t vectorSize;
+            std::memcpy(&vectorSize, m_buffer.data() + m_pos, sizeof(vectorSize));
+            uint64_t needed = sizeof(uint32_t) + static_cast<uint64_t>(vectorSize) * sizeof(uint32_t);
+            if (available < needed) break;
+
+            m_pos += static_cast<size_t>(needed);
+            m_remaining--;
+            completed++;
+        }
+
+        m_buffer.erase(0, m_pos);
+        m_pos = 0;
+        return completed;
+    }
+
+private:
+    std::string m_buffer;
+    size_t m_pos = 0;
+    bool m_haveCount = false;
+    uint32_t m_remaining = 0;
+};
+
+void showHelp(const char* programName) {
+    std::cout << "Использование: " << programName << " -f FILE -c FILE [опции]\n"
+              << "Воспроизведение записанного трафика на сервере\n"
+              << "Опции:\n"
+              << "  -h, --help          Показать эту справку\n"
+              << "  -f FILE             Файл записи трафика\n"
+              << "  -H HOST             IPv4-адрес сервера (по умолчанию: 127.0.0.1)\n"
+              << "  -p PORT             Порт сервера (по умолчанию: 33333)\n"
+              << "  -c FILE             База пользователей для пересчета хешей с новой солью (обязательно)\n"
+              << "  -x SPEED            Множитель скорости, 0 - максимальная (по умолчанию: 1)\n"
+              << "  -j N                Число параллельных соединений при -x 0 (по умолчанию: 16);\n"
+              << "                      в остальных режимах соединения начинаются по расписанию записи\n"
+              << "\nПример:\n"
+              << "  " << programName << " -f vcalc.cap -c vcalc.conf -x 0 -j 64\n";
+}
+
+bool sendAll(int sock, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(sock, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recvAll(int sock, void* buffer, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        ssize_t n = recv(sock, static_cast<char*>(buffer) + received, length - received, 0);
+        if (n <= 0) {
+            return false;
+        }
+        received += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+uint64_t elapsedUs(Clock::time_point from) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - from).count());
+}
+
+// Момент отправки по записи с учетом множителя скорости
+Clock::time_point scheduledTime(Clock::time_point base, uint64_t offsetUs, double speed) {
+    return base + std::chrono::microseconds(static_cast<uint64_t>(offsetUs / speed));
+}
+
+// Ожидание момента отправки; при максимальной скорости ожидания нет
+void waitUntil(Clock::time_point base, uint64_t offsetUs, double speed) {
+    if (speed <= 0) {
+        return;
+    }
+    std::this_thread::sleep_until(scheduledTime(base, offsetUs, speed));
+}
+
+int connectTo(const std::string& host, uint16_t port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    struct timeval timeout = {10, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    // Блоки отправляются так, как были записаны, без склейки алгоритмом Нейгла
+    int noDelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    struct sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &serverAddr.sin_addr) != 1 ||
+        connect(sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// Воспроизведение одного соединения
+ReplayResult replayConnection(const TrafficCapture::Connection& connection, const std::string& host,
+                              uint16_t port, const UserDatabase& users, double speed) {
+    ReplayResult result;
+    int sock = connectTo(host, port);
+    if (sock < 0) {
+        return result;
+    }
+    result.connected = true;
+    Clock::time_point start = Clock::now();
+    const auto& chunks = connection.chunks;
+
+    // Сессия завершилась до проверки хеша: отправляются записанные блоки
+    // без ожидания ответов, как это сделал клиент
+    if (connection.auth == TrafficCapture::AuthResult::NOT_REACHED) {
+        for (const auto& chunk : chunks) {
+            waitUntil(start, chunk.offsetUs, speed);
+            if (!sendAll(sock, chunk.data)) {
+                close(sock);
+                return result;
+            }
+            result.bytesSent += chunk.data.size();
+        }
+        waitUntil(start, connection.durationUs, speed);
+        close(sock);
+        result.completed = connection.closed;
+        return result;
+    }
+
+    // Первые два блока - логин и хеш
+    if (chunks.size() < 2) {
+        close(sock);
+        return result;
+    }
+
+    waitUntil(start, chunks[0].offsetUs, speed);
+    char salt[SALT_LENGTH];
+    if (!sendAll(sock, chunks[0].data) || !recvAll(sock, salt, sizeof(salt))) {
+        close(sock);
+        return result;
+    }
+    result.bytesSent += chunks[0].data.size();
+
+    // Хеш пересчитывается только для сессий, успешных в записи;
+    // для неуспешных отправляется заведомо неверный хеш той же длины
+    // Логин обрезается по первому NUL, как это делает сервер
+    std::string hash = chunks[1].data;
+    std::string password;
+    if (connection.auth == TrafficCapture::AuthResult::FAILED) {
+        hash.assign(chunks[1].data.size(), '0');
+    } else if (users.find(std::string(chunks[0].data.c_str()), password)) {
+        hash = SHA256::hash(std::string(salt, sizeof(salt)) + password);
+        for (char& c : hash) {
+            c = std::toupper(c);
+        }
+    }
+
+    waitUntil(start, chunks[1].offsetUs, speed);
+    Clock::time_point authSent = Clock::now();
+    char response[4] = {0};
+    if (!sendAll(sock, hash) || recv(sock, response, sizeof(response) - 1, 0) <= 0) {
+        close(sock);
+        return result;
+    }
+    result.bytesSent += hash.size();
+    result.authLatencyUs = elapsedUs(authSent);
+    result.authResponded = true;
+    bool authOk = std::string(response) == "OK";
+    result.authMismatch = authOk != (connection.auth == TrafficCapture::AuthResult::SUCCEEDED);
+    if (!authOk) {
+        // Сервер закрывает соединение после отказа; сессия воспроизведена
+        // полностью, если отказ был и в записи
+        close(sock);
+        result.completed = !result.authMismatch && connection.closed;
+        return result;
+    }
+    result.authenticated = true;
+
+    // Остальные блоки - поток векторов; после каждого блока ожидаются ответы
+    // на все векторы, которые он завершил
+    VectorStream stream;
+    for (size_t i = 2; i < chunks.size(); i++) {
+        waitUntil(start, chunks[i].offsetUs, speed);
+        Clock::time_point sent = Clock::now();
+        if (!sendAll(sock, chunks[i].data)) {
+            close(sock);
+            return result;
+        }
+        result.bytesSent += chunks[i].data.size();
+
+        uint32_t expected = stream.append(chunks[i].data);
+        for (uint32_t j = 0; j < expected; j++) {
+            uint32_t value;
+            if (!recvAll(sock, &value, sizeof(value))) {
+                close(sock);
+                return result;
+            }
+            result.vectorLatenciesUs.push_back(elapsedUs(sent));
+        }
+    }
+
+    waitUntil(start, connection.durationUs, speed);
+    close(sock);
+    // Если запись оборвалась (лимит размера), поток отправлен не полностью
+    result.completed = connection.closed;
+    return result;
+}
+
+void printLatencies(const std::string& title, std::vector<uint64_t>& latencies) {
+    if (latencies.empty()) {
+        std::cout << title << ": нет данных" << std::endl;
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t index = static_cast<size_t>(p * (latencies.size() - 1));
+        return latencies[index];
+    };
+    uint64_t sum = 0;
+    for (uint64_t value : latencies) {
+        sum += value;
+    }
+
+    std::cout << title << " (мкс): "
+              << "среднее " << sum / latencies.size()
+              << ", p50 " << percentile(0.50)
+              << ", p90 " << percentile(0.90)
+              << ", p99 " << percentile(0.99)
+              << ", max " << latencies.back() << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string captureFile;
+    std::string host = "127.0.0.1";
+    std::string userDbFile;
+    int port = 33333;
+    double speed = 1.0;
+    int parallel = 16;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "hf:H:p:c:x:j:")) != -1) {
+        try {
+            switch (opt) {
+                case 'h':
+                    showHelp(argv[0]);
+                    return 0;
+                case 'f':
+                    captureFile = optarg;
+                    break;
+                case 'H':
+                    host = optarg;
+                    break;
+                case 'p':
+                    port = std::stoi(optarg);
+                    break;
+                case 'c':
+                    userDbFile = optarg;
+                    break;
+                case 'x':
+                    speed = std::stod(optarg);
+                    break;
+                case 'j':
+                    parallel = std::stoi(optarg);
+                    break;
+                default:
+                    showHelp(argv[0]);
+                    return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Ошибка: Неверное значение параметра -" << static_cast<char>(opt)
+                      << ": " << optarg << std::endl;
+            return 1;
+        }
+    }
+
+    if (captureFile.empty()) {
+        showHelp(argv[0]);
+        return 1;
+    }
+    // Без базы пользователей хеш не пересчитать для новой соли, и все
+    // соединения будут отклонены сервером без передачи векторов
+    if (userDbFile.empty()) {
+        std::cerr << "Ошибка: Не указана база пользователей (-c)" << std::endl;
+        showHelp(argv[0]);
+        return 1;
+    }
+    if (port <= 0 || port > 65535 || !std::isfinite(speed) || speed < 0 || parallel <= 0) {
+        std::cerr << "Ошибка: Неверные параметры воспроизведения" << std::endl;
+        return 1;
+    }
+
+    std::vector<TrafficCapture::Connection> connections;
+    if (!TrafficCapture::load(captureFile, connections)) {
+        return 1;
+    }
+
+    UserDatabase users;
+    if (!users.load(userDbFile)) {
+        return 1;
+    }
+
+    std::cout << "Соединений в записи: " << connections.size() << std::endl;
+
+    // Соединения запускаются в порядке начала по записи
+    std::stable_sort(connections.begin(), connections.end(),
+                     [](const auto& a, const auto& b) { return a.startUs < b.startUs; });
+
+    std::vector<ReplayResult> results(connections.size());
+    Clock::time_point replayStart = Clock::now();
+
+    auto replay = [&](size_t index) {
+        const auto& connection = connections[index];
+        uint64_t startLagUs = 0;
+        if (speed > 0) {
+            Clock::time_point scheduled = scheduledTime(replayStart, connection.startUs, speed);
+            if (Clock::now() > scheduled) {
+                startLagUs = elapsedUs(scheduled);
+            }
+        }
+        results[index] = replayConnection(connection, host, static_cast<uint16_t>(port), users, speed);
+        results[index].startLagUs = startLagUs;
+    };
+
+    if (speed > 0) {
+        // Каждое соединение начинается в свой момент по записи в отдельном потоке,
+        // поэтому число одновременных соединений совпадает с записанным
+        std::mutex activeMutex;
+        std::condition_variable activeDone;
+        size_t active = 0;
+
+        for (size_t i = 0; i < connections.size(); i++) {
+            waitUntil(replayStart, connections[i].startUs, speed);
+            {
+                std::lock_guard<std::mutex> lock(activeMutex);
+                active++;
+            }
+            try {
+                std::thread([&, i]() {
+                    replay(i);
+                    std::lock_guard<std::mutex> lock(activeMutex);
+                    if (--active == 0) {
+                        activeDone.notify_all();
+                    }
+                }).detach();
+            } catch (const std::system_error& e) {
+                std::cerr << "Ошибка: Не удалось создать поток для соединения: " << e.what() << std::endl;
+                std::lock_guard<std::mutex> lock(activeMutex);
+                active--;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(activeMutex);
+        activeDone.wait(lock, [&active]() { return active == 0; });
+    } else {
+        // При максимальной скорости число одновременных соединений задает -j
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            while (true) {
+                size_t index = next++;
+                if (index >= connections.size()) {
+                    break;
+                }
+                replay(index);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < parallel; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+    double seconds = elapsedUs(replayStart) / 1e6;
+
+    size_t connected = 0, authenticated = 0, completed = 0, authMismatches = 0;
+    uint64_t bytesSent = 0;
+    std::vector<uint64_t> authLatencies;
+    std::vector<uint64_t> vectorLatencies;
+    std::vector<uint64_t> startLags;
+    size_t lateStarts = 0;
+    for (auto& result : results) {
+        startLags.push_back(result.startLagUs);
+        lateStarts += result.startLagUs > START_LAG_WARNING_US;
+        connected += result.connected;
+        authenticated += result.authenticated;
+        authMismatches += result.authMismatch;
+        completed += result.completed;
+        bytesSent += result.bytesSent;
+        // Учитываются и отклоненные сессии, если исход совпал с записью
+        if (result.authResponded && !result.authMismatch) {
+            authLatencies.push_back(result.authLatencyUs);
+        }
+        vectorLatencies.insert(vectorLatencies.end(), result.vectorLatenciesUs.begin(),
+                               result.vectorLatenciesUs.end());
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Время воспроизведения: " << seconds << " с" << std::endl
+              << "Соединений: " << connected << " подключено, " << authenticated
+              << " аутентифицировано, " << completed << " завершено из " << results.size() << std::endl
+              << "Расхождений аутентификации с записью: " << authMismatches << std::endl
+              << "Векторов: " << vectorLatencies.size() << std::endl;
+    if (seconds > 0) {
+        std::cout << "Пропускная способность: " << completed / seconds << " соединений/с, "
+                  << vectorLatencies.size() / seconds << " векторов/с, "
+                  << bytesSent / seconds / 1024 << " КБ/с" << std::endl;
+    }
+    printLatencies("Задержка аутентификации", authLatencies);
+    printLatencies("Задержка вектора", vectorLatencies);
+    if (speed > 0) {
+        printLatencies("Опоздание начала соединений", startLags);
+        if (lateStarts > 0) {
+            std::cout << "Внимание: " << lateStarts << " соединений начались позже записи более чем на "
+                      << START_LAG_WARNING_US / 1000 << " мс; нагрузка не соответствует записи, "
+                      << "результаты нельзя сравнивать" << std::endl;
+        }
+    }
+
+    return connected == results.size() ? 0 : 2;
+}